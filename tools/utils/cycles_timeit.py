@@ -8,6 +8,8 @@ __all__ = (
 )
 
 import argparse
+import csv
+import json
 import re
 import shutil
 import subprocess
@@ -119,6 +121,35 @@ def configureArgumentParser():
                              "to use for rendering",
                         default="blender")
     parser.add_argument("-f", "--files", nargs='+')
+    parser.add_argument("-s", "--frame-start",
+                        help="First frame to render, the scene start frame " +
+                             "is used when only --frame-end is given " +
+                             "(renders only frame 1 when neither is given)",
+                        type=int,
+                        default=None)
+    parser.add_argument("-e", "--frame-end",
+                        help="Last frame to render, inclusive, the scene " +
+                             "end frame is used when only --frame-start is given",
+                        type=int,
+                        default=None)
+    parser.add_argument("--persistent-data",
+                        help="Keep render data between frames, only " +
+                             "re-synchronizing what changed",
+                        action="store_true",
+                        default=False)
+    parser.add_argument("--adaptive-threshold",
+                        help="Enable adaptive sampling with the given " +
+                             "noise threshold",
+                        type=float,
+                        default=None)
+    parser.add_argument("--output-json",
+                        help="Write a summary of the timings and sample counts " +
+                             "to the given JSON file",
+                        default=None)
+    parser.add_argument("--output-csv",
+                        help="Write per-frame timings and sample counts to the " +
+                             "given CSV file",
+                        default=None)
     parser.add_argument("-v", "--verbose",
                         help="Perform fully verbose communication",
                         action="store_true",
@@ -126,9 +157,61 @@ def configureArgumentParser():
     return parser
 
 
-def benchmarkFile(blender, blendfile, stats):
+def frameRangeArguments(frame_start, frame_end):
+    if frame_start is None and frame_end is None:
+        return ("-f", "1")
+    # A missing bound is taken from the scene by Blender.
+    arguments = ()
+    if frame_start is not None:
+        arguments += ("-s", str(frame_start))
+    if frame_end is not None:
+        arguments += ("-e", str(frame_end))
+    return arguments + ("-a",)
+
+
+def addTime(total, seconds):
+    if total is None:
+        return seconds
+    return total + seconds
+
+
+def printTotalTime(label, seconds):
+    if seconds is None:
+        print("{}: N/A" . format(label))
+        return
+    print("{}: {} ({} sec)"
+          . format(label, humanReadableTimeDifference(seconds), seconds))
+
+
+def printFrameStats(frame_stats):
+    print("Per-frame timing:")
+    print("  {:>6}  {:>12}  {:>12}  {:>12}  {:>6}"
+          . format("Frame", "Pipeline", "Cycles", "Sync", "Sync%"))
+    for frame, frame_stat in sorted(frame_stats.items()):
+        total = frame_stat.get('CYCLES_TOTAL')
+        no_sync = frame_stat.get('CYCLES_NO_SYNC')
+        pipeline = frame_stat.get('PIPELINE_TOTAL')
+        sync = "N/A"
+        sync_percent = "N/A"
+        if total is not None and no_sync is not None:
+            sync = total - no_sync
+            if total > 0.0:
+                sync_percent = "{:.1f}" . format(100.0 * sync / total)
+            sync = humanReadableTimeDifference(sync)
+        print("  {:>6}  {:>12}  {:>12}  {:>12}  {:>6}"
+              . format(frame,
+                       "N/A" if pipeline is None else humanReadableTimeDifference(pipeline),
+                       "N/A" if total is None else humanReadableTimeDifference(total),
+                       sync,
+                       sync_percent))
+
+
+def benchmarkFile(blender, blendfile, stats, frame_range, use_persistent_data,
+                  adaptive_threshold):
     logHeader("Begin benchmark of file {}" . format(blendfile))
     # Prepare some regex for parsing
+    re_frame = re.compile(r"^Fra:([0-9]+) ")
+    re_sample = re.compile(r".*Sample ([0-9]+)/([0-9]+)")
     re_path_tracing = re.compile(".*Path Tracing Tile ([0-9]+)/([0-9]+)$")
     re_total_render_time = re.compile(r".*Total render time: ([0-9]+(\.[0-9]+)?)")
     re_render_time_no_sync = re.compile(
@@ -138,15 +221,26 @@ def benchmarkFile(blender, blendfile, stats):
     # TODO(sergey): Use some proper output folder.
     output_folder = "/tmp/"
     # Configure command for the current file.
-    command = (blender,
+    command = [blender,
                "--background",
                "--factory-startup",
                blendfile,
                "--engine", "CYCLES",
                "--debug-cycles",
                "--render-output", output_folder,
-               "--render-format", "PNG",
-               "-f", "1")
+               "--render-format", "PNG"]
+    python_statements = []
+    if use_persistent_data:
+        python_statements.append("scene.render.use_persistent_data = True")
+    if adaptive_threshold is not None:
+        python_statements.append("scene.cycles.use_adaptive_sampling = True")
+        python_statements.append("scene.cycles.adaptive_threshold = {!r}"
+                                 . format(adaptive_threshold))
+    if python_statements:
+        command += ["--python-expr",
+                    "; " . join(["import bpy", "scene = bpy.context.scene"] +
+                                python_statements)]
+    command += frame_range
     # Run Blender with configured command line.
     logVerbose("About to execute command: {}" . format(command))
     start_time = time.time()
@@ -154,9 +248,15 @@ def benchmarkFile(blender, blendfile, stats):
                                stdout=subprocess.PIPE,
                                stderr=subprocess.STDOUT)
     # Keep reading status while Blender is alive.
-    total_render_time = "N/A"
-    render_time_no_sync = "N/A"
-    pipeline_render_time = "N/A"
+    # Timings are accumulated over all rendered frames and also kept per frame,
+    # so that synchronization overhead can be compared between frames.
+    current_frame = None
+    frame_stats = {}
+    # Totals stay None when no frame reported the corresponding time
+    # (e.g. Blender build without Cycles debug output).
+    total_render_time = None
+    render_time_no_sync = None
+    pipeline_render_time = None
     while True:
         line = process.stdout.readline()
         if line == b"" and process.poll() is not None:
@@ -165,6 +265,10 @@ def benchmarkFile(blender, blendfile, stats):
         if line == "":
             continue
         logVerbose("Line from stdout: {}" . format(line))
+        match = re_frame.match(line)
+        if match:
+            current_frame = int(match.group(1))
+        frame_stat = frame_stats.setdefault(current_frame, {})
         match = re_path_tracing.match(line)
         if match:
             current_tiles = int(match.group(1))
@@ -174,46 +278,84 @@ def benchmarkFile(blender, blendfile, stats):
             progress(current_tiles,
                      total_tiles,
                      prefix="Path Tracing Tiles {}" . format(elapsed_time_str))
+        match = re_sample.match(line)
+        if match:
+            # Keep the last reported progress, with adaptive sampling the
+            # render may finish before reaching the maximum sample count.
+            frame_stat['SAMPLES'] = int(match.group(1))
+            frame_stat['SAMPLES_MAX'] = int(match.group(2))
         match = re_total_render_time.match(line)
         if match:
-            total_render_time = float(match.group(1))
+            frame_stat['CYCLES_TOTAL'] = float(match.group(1))
+            total_render_time = addTime(total_render_time, frame_stat['CYCLES_TOTAL'])
         match = re_render_time_no_sync.match(line)
         if match:
-            render_time_no_sync = float(match.group(1))
+            frame_stat['CYCLES_NO_SYNC'] = float(match.group(1))
+            render_time_no_sync = addTime(render_time_no_sync, frame_stat['CYCLES_NO_SYNC'])
         match = re_pipeline_time.match(line)
         if match:
-            pipeline_render_time = humanReadableTimeToSeconds(match.group(1))
+            frame_stat['PIPELINE_TOTAL'] = humanReadableTimeToSeconds(match.group(1))
+            pipeline_render_time = addTime(pipeline_render_time, frame_stat['PIPELINE_TOTAL'])
 
     if process.returncode != 0:
         return False
 
+    # Lines printed before the first frame carry no timing information.
+    frame_stats = {frame: frame_stat
+                   for frame, frame_stat in frame_stats.items()
+                   if frame is not None and frame_stat}
+
     # Clear line used by progress.
     progressClear()
-    print("Total pipeline render time: {} ({} sec)"
-          . format(humanReadableTimeDifference(pipeline_render_time),
-                   pipeline_render_time))
-    print("Total Cycles render time: {} ({} sec)"
-          . format(humanReadableTimeDifference(total_render_time),
-                   total_render_time))
-    print("Pure Cycles render time (without sync): {} ({} sec)"
-          . format(humanReadableTimeDifference(render_time_no_sync),
-                   render_time_no_sync))
+    if len(frame_stats) > 1:
+        printFrameStats(frame_stats)
+    printTotalTime("Total pipeline render time", pipeline_render_time)
+    printTotalTime("Total Cycles render time", total_render_time)
+    printTotalTime("Pure Cycles render time (without sync)", render_time_no_sync)
     logOk("Successfully rendered")
-    stats[blendfile] = {'PIPELINE_TOTAL': pipeline_render_time,
+    stats[blendfile] = {'ADAPTIVE_THRESHOLD': adaptive_threshold,
+                        'PIPELINE_TOTAL': pipeline_render_time,
                         'CYCLES_TOTAL': total_render_time,
-                        'CYCLES_NO_SYNC': render_time_no_sync}
+                        'CYCLES_NO_SYNC': render_time_no_sync,
+                        'FRAMES': frame_stats}
     return True
 
 
-def benchmarkAll(blender, files):
+def writeStatsJSON(stats, filepath):
+    with open(filepath, "w", encoding="utf-8") as fh:
+        json.dump(stats, fh, indent=2, sort_keys=True)
+
+
+def writeStatsCSV(stats, filepath):
+    with open(filepath, "w", encoding="utf-8", newline="") as fh:
+        writer = csv.writer(fh)
+        writer.writerow(("file", "adaptive_threshold", "frame",
+                         "samples", "samples_max",
+                         "pipeline_total", "cycles_total", "cycles_no_sync"))
+        for blendfile, file_stats in sorted(stats.items()):
+            for frame, frame_stat in sorted(file_stats['FRAMES'].items()):
+                adaptive_threshold = file_stats['ADAPTIVE_THRESHOLD']
+                writer.writerow((blendfile,
+                                 "" if adaptive_threshold is None else adaptive_threshold,
+                                 frame,
+                                 frame_stat.get('SAMPLES', ""),
+                                 frame_stat.get('SAMPLES_MAX', ""),
+                                 frame_stat.get('PIPELINE_TOTAL', ""),
+                                 frame_stat.get('CYCLES_TOTAL', ""),
+                                 frame_stat.get('CYCLES_NO_SYNC', "")))
+
+
+def benchmarkAll(blender, files, frame_range, use_persistent_data, adaptive_threshold):
     stats = {}
     for blendfile in files:
         try:
-            benchmarkFile(blender, blendfile, stats)
+            benchmarkFile(blender, blendfile, stats, frame_range, use_persistent_data,
+                          adaptive_threshold)
         except KeyboardInterrupt:
             print("")
             logWarning("Rendering aborted!")
-            return
+            break
+    return stats
 
 
 def main():
@@ -222,7 +364,14 @@ def main():
     if args.verbose:
         global VERBOSE
         VERBOSE = True
-    benchmarkAll(args.binary, args.files)
+    frame_range = frameRangeArguments(args.frame_start, args.frame_end)
+    stats = benchmarkAll(args.binary, args.files, frame_range, args.persistent_data,
+                         args.adaptive_threshold)
+    # Files which were rendered before an abort are still written out.
+    if args.output_json:
+        writeStatsJSON(stats, args.output_json)
+    if args.output_csv:
+        writeStatsCSV(stats, args.output_csv)
 
 
 if __name__ == "__main__":
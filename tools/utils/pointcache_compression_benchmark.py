@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+"""
+Measure compression ratio and throughput of point-cache codecs on existing cache files.
+
+The contents of each file are compressed as a whole, so caches should be baked without
+compression (Cache > Compression: None) for the numbers to be meaningful.
+
+LZMA is always available, LZO and ZSTD are measured when the ``lzo`` (python-lzo)
+and ``zstandard`` modules can be imported.
+
+Example usage:
+
+   ./pointcache_compression_benchmark.py blendcache_foo/*.bphys
+
+Only measure ZSTD at a few levels using 8 threads:
+
+   ./pointcache_compression_benchmark.py --codecs zstd --zstd-levels 1 3 9 --threads 8 blendcache_foo/*.bphys
+"""
+
+__all__ = (
+    "main",
+)
+
+import argparse
+import lzma
+import sys
+import time
+
+from collections.abc import (
+    Callable,
+    Sequence,
+)
+from typing import (
+    Any,
+)
+
+try:
+    import lzo  # type: ignore[import-not-found]
+except ImportError:
+    lzo = None
+
+try:
+    import zstandard as zstd  # type: ignore[import-not-found]
+except ImportError:
+    zstd = None
+
+
+CodecFn = Callable[[bytes], bytes]
+
+# Raw LZMA1 stream using the LZMA SDK parameters of the point-cache
+# (level 5, 16 MiB dictionary, `lc=3`, `lp=0`, `pb=2`, `fb=32`).
+# The 5 property bytes the point-cache stores per data array are not counted.
+LZMA_FILTERS: list[dict[str, Any]] = [{
+    "id": lzma.FILTER_LZMA1,
+    "preset": 5,
+    "dict_size": 1 << 24,
+    "lc": 3,
+    "lp": 0,
+    "pb": 2,
+    "nice_len": 32,
+}]
+
+
+def lzma_compress(data: bytes) -> bytes:
+    return lzma.compress(data, format=lzma.FORMAT_RAW, filters=LZMA_FILTERS)
+
+
+def lzma_decompress(data: bytes) -> bytes:
+    return lzma.decompress(data, format=lzma.FORMAT_RAW, filters=LZMA_FILTERS)
+
+
+def codecs_create(
+        codec_names: Sequence[str],
+        zstd_levels: Sequence[int],
+        threads: int,
+) -> list[tuple[str, CodecFn, CodecFn]]:
+    """
+    Return a list of ``(name, compress_fn, decompress_fn)`` tuples.
+    """
+    codecs: list[tuple[str, CodecFn, CodecFn]] = []
+    if "lzo" in codec_names:
+        if lzo is None:
+            print("Warning: 'lzo' module not found, skipping LZO", file=sys.stderr)
+        else:
+            codecs.append(("lzo", lzo.compress, lzo.decompress))
+    if "lzma" in codec_names:
+        codecs.append(("lzma", lzma_compress, lzma_decompress))
+    if "zstd" in codec_names:
+        if zstd is None:
+            print("Warning: 'zstandard' module not found, skipping ZSTD", file=sys.stderr)
+        else:
+            decompressor = zstd.ZstdDecompressor()
+            for level in zstd_levels:
+                compressor = zstd.ZstdCompressor(level=level, threads=threads)
+                codecs.append((
+                    "zstd-{:d}".format(level),
+                    compressor.compress,
+                    decompressor.decompress,
+                ))
+    return codecs
+
+
+def benchmark_codec(
+        compress_fn: CodecFn,
+        decompress_fn: CodecFn,
+        files_data: Sequence[bytes],
+        repeat: int,
+) -> tuple[int, float, float]:
+    """
+    Return ``(size_compressed, time_compress, time_decompress)`` summed over all files,
+    using the best of ``repeat`` runs for the timings.
+    """
+    size_compressed = 0
+    time_compress = 0.0
+    time_decompress = 0.0
+    for data in files_data:
+        best_compress = best_decompress = float("inf")
+        data_compressed = data_decompressed = b""
+        for _ in range(repeat):
+            t = time.perf_counter()
+            data_compressed = compress_fn(data)
+            best_compress = min(best_compress, time.perf_counter() - t)
+
+            t = time.perf_counter()
+            data_decompressed = decompress_fn(data_compressed)
+            best_decompress = min(best_decompress, time.perf_counter() - t)
+
+        if data_decompressed != data:
+            raise Exception("Round-trip mismatch, codec is broken")
+
+        size_compressed += len(data_compressed)
+        time_compress += best_compress
+        time_decompress += best_decompress
+    return size_compressed, time_compress, time_decompress
+
+
+def argparse_create() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    parser.add_argument(
+        "files",
+        nargs="+",
+        help="Point-cache files (*.bphys) to compress",
+    )
+    parser.add_argument(
+        "--codecs",
+        nargs="+",
+        choices=("lzo", "lzma", "zstd"),
+        default=("lzo", "lzma", "zstd"),
+        help="Codecs to measure",
+    )
+    parser.add_argument(
+        "--zstd-levels",
+        nargs="+",
+        type=int,
+        default=(1, 3, 9, 19),
+        help="ZSTD compression levels to measure",
+    )
+    parser.add_argument(
+        "--threads",
+        type=int,
+        default=0,
+        help="ZSTD compression threads (0: single threaded, -1: all cores)",
+    )
+    parser.add_argument(
+        "--repeat",
+        type=int,
+        default=3,
+        help="Number of runs per file, the fastest one is used",
+    )
+    return parser
+
+
+def main() -> None:
+    args = argparse_create().parse_args()
+
+    files_data: list[bytes] = []
+    for filepath in args.files:
+        with open(filepath, "rb") as fh:
+            files_data.append(fh.read())
+    size_total = sum(len(data) for data in files_data)
+    if size_total == 0:
+        print("No data to compress")
+        return
+
+    # Create codecs first so warnings about missing modules are not printed inside the table.
+    codecs = codecs_create(args.codecs, args.zstd_levels, args.threads)
+
+    print("{:d} file(s), {:.2f} MiB".format(len(files_data), size_total / (1 << 20)))
+    print("{:<10} {:>8} {:>14} {:>16}".format("Codec", "Ratio", "Compress MiB/s", "Decompress MiB/s"))
+
+    size_total_mib = size_total / (1 << 20)
+    for name, compress_fn, decompress_fn in codecs:
+        size_compressed, time_compress, time_decompress = benchmark_codec(
+            compress_fn, decompress_fn, files_data, max(args.repeat, 1),
+        )
+        print("{:<10} {:>8.3f} {:>14.1f} {:>16.1f}".format(
+            name,
+            size_total / max(size_compressed, 1),
+            size_total_mib / max(time_compress, 1e-9),
+            size_total_mib / max(time_decompress, 1e-9),
+        ))
+
+
+if __name__ == "__main__":
+    main()